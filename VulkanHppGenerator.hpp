@@ -14,35 +14,120 @@
 
 #pragma once
 
+#include <cstdint>
+#include <functional>
 #include <iostream>
 #include <map>
+#include <mutex>
 #include <set>
-#include <tinyxml2.h>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+class FragmentCache;
+class Profiler;
+class SizeReport;
+class XmlAttributes;
+class XmlNode;
+class XmlReader;
+
+// the entries a fragment is rendered from, recorded while it's rendered: the index of the container each one is read
+// from in the generator's m_fragmentSources, and its name, or an empty name for a container read as a whole
+using FragmentReads = std::set<std::pair<size_t, std::string>>;
+
+// where the code of each group of a size report begins in a string, up to the next mark; an empty group is the code
+// common to all of them
+using SizeMarks = std::vector<std::pair<size_t, std::string>>;
+
+// the naming and feature options a header is generated with; the defaults are the compile definitions listed in the
+// README, and a configuration file can override each of them
+struct GeneratorOptions
+{
+  GeneratorOptions();
+
+  std::string commandPrefix;
+  std::string macroPrefix;
+  std::string structPrefix;
+  std::string enumPrefix;        // empty for macroPrefix
+  std::string resultEnumPrefix;  // empty for enumPrefix
+  std::string defaultNamespace;
+  std::string instanceHandleName;
+  std::string specApiName;
+  std::string headerName;
+  std::string headerMacro;
+  std::string includedFilename;
+  std::string includedBindings;  // empty for none
+  std::string subsetVersion;     // the latest feature to generate, empty for all of them
+  std::string subsetExtensions;  // the extensions and platforms to generate, comma separated
+  std::string usageManifest;     // the file listing the commands and types to generate, empty for all of them
+  std::string moduleName;        // the name of a C++20 module to generate along with the header, empty for none
+  bool        dispatch                  = true;
+  bool        allocationCallbacks       = true;
+  bool        versionCheck              = true;
+  bool        structureChain            = true;
+  bool        objectTypeEnum            = true;
+  bool        debugReportObjectTypeEnum = true;
+  bool        structureTypeEnum         = true;
+  bool        indexTypeTraits           = true;
+  bool        objectEndDeleter          = false;
+  bool        splitOutput               = false;  // the header includes part headers, rather than being a single file
+  bool        modulePartitions          = false;  // the module is made of a partition per section
+  bool        outOfLine                 = false;  // the bulk of the definitions go to a source file
+};
+
 class VulkanHppGenerator
 {
+  friend class SnapshotArchive;
+
 public:
-  VulkanHppGenerator( tinyxml2::XMLDocument const & document );
+  VulkanHppGenerator( XmlReader &              reader,
+                      GeneratorOptions const & options,
+                      size_t                   threadCount = 1,
+                      Profiler *               profiler    = nullptr,
+                      bool                     trusted     = false );  // a trusted spec isn't checked for correctness
+  VulkanHppGenerator( char const *             snapshot,
+                      size_t                   size,
+                      GeneratorOptions const & options,
+                      Profiler *               profiler = nullptr );  // restores the state written by writeSnapshot
 
   void appendBaseTypes( std::string & str ) const;
   void appendBitmasks( std::string & str ) const;
-  void appendDispatchLoaderDynamic( std::string & str );  // use vkGet*ProcAddress to get function pointers
-  void appendDispatchLoaderStatic( std::string & str );   // use exported symbols from loader
+  void appendBitmasksToStringDefinitions( std::string & str ) const;  // the out-of-line part of the bitmasks
+  void appendCommandAnalyses( std::string & str ) const;              // how each command is wrapped, for auditing
+  void appendDispatchLoaderDynamic( std::string & str ) const;        // use vkGet*ProcAddress to get function pointers
+  void appendDispatchLoaderStatic( std::string & str );               // use exported symbols from loader
   void appendDispatchLoaderDefault(
     std::string & str );  // typedef to DispatchLoaderStatic or undefined type, based on VK_NO_PROTOTYPES
-  void                appendEnums( std::string & str ) const;
-  void                appendHandles( std::string & str );
-  void                appendHandlesCommandDefinitions( std::string & str ) const;
-  void                appendHashStructures( std::string & str ) const;
-  void                appendResultExceptions( std::string & str ) const;
-  void                appendStructs( std::string & str );
-  void                appendStructureChainValidation( std::string & str );
-  void                appendThrowExceptions( std::string & str ) const;
-  void                appendIndexTypeTraits( std::string & str ) const;
-  std::string const & getTypesafeCheck() const;
-  std::string const & getVersion() const;
-  std::string const & getVulkanLicenseHeader() const;
+  void                     appendEmissionOrder( std::string & str ) const;  // the order of the handles and structs
+  void                     appendEnums( std::string & str ) const;
+  void                     appendEnumsExports( std::string & str ) const;  // using-declarations of a C++20 module
+  void                     appendEnumsToStringDefinitions( std::string & str ) const;
+  void                     appendHandles( std::string & str ) const;
+  void                     appendHandlesCommandDefinitions( std::string & str ) const;
+  void                     appendHandlesCommandSourceDefinitions( std::string & str ) const;
+  void                     appendHandlesExports( std::string & str ) const;
+  void                     appendHashStructures( std::string & str ) const;
+  void                     appendHashStructuresExports( std::string & str ) const;
+  void                     appendResultExceptions( std::string & str ) const;
+  void                     appendResultExceptionsDefinitions( std::string & str ) const;
+  void                     appendResultExceptionsExports( std::string & str ) const;
+  void                     appendStructs( std::string & str ) const;
+  void                     appendStructsExports( std::string & str ) const;
+  void                     appendStructsLayoutChecks( std::string & str ) const;  // the out-of-line part of the structs
+  void                     appendStructureChainValidation( std::string & str );
+  void                     appendThrowExceptions( std::string & str, bool definition ) const;
+  void                     appendIndexTypeTraits( std::string & str ) const;
+  void                     appendKeptReasons( std::string & str ) const;  // why selectUsed kept each entity
+  GeneratorOptions const & getOptions() const;
+  std::string const &      getTypesafeCheck() const;
+  std::string const &      getVersion() const;
+  std::string const &      getVulkanLicenseHeader() const;
+  void                     selectUsed( std::string const & manifest );  // keeps just what the manifest depends on
+  void                     setFragmentCache( FragmentCache * fragmentCache, size_t target );
+  void                     setSizeReport( SizeReport * sizeReport );       // per feature and extension
+  void                     setThreadCount( size_t threadCount );           // threads emitting the code
+  SizeMarks                takeSizeMarks( std::string const & str );       // str's size groups
+  void                     writeSnapshot( std::string & snapshot ) const;  // the parsed and validated state
 
 private:
   struct BaseTypeData
@@ -74,7 +159,7 @@ private:
 
   struct TypeInfo
   {
-    std::string compose( bool inNamespace = true ) const;
+    std::string compose( GeneratorOptions const & options, bool inNamespace = true ) const;
 
     bool operator==( TypeInfo const & rhs ) const
     {
@@ -109,6 +194,7 @@ private:
     std::string prefix;
     std::string type;
     std::string postfix;
+    uint32_t    id = ~uint32_t( 0 );  // the id of type in the NameTable, once deriveNames has interned it
   };
 
   struct ParamData
@@ -147,6 +233,92 @@ private:
     int                                     xmlLine;
   };
 
+  // the way a command (or a command alias) is wrapped, as determined by its parameters and its return type
+  enum class CommandFlavour
+  {
+    Chained,
+    Singular,
+    Standard,
+    StandardAndEnhanced,
+    StandardEnhancedDeprecatedAllocator,
+    StandardOrEnhanced,
+    Unique,
+    Unsupported,  // a command like no other, that can't be wrapped
+    Vector,
+    VectorChained,
+    VectorDeprecated,
+    VectorSingularUnique,
+    VectorUnique
+  };
+
+  // the shape of a command (or a command alias), determined once after reading the spec
+  struct CommandAnalysis
+  {
+    bool                     complexBody = false;  // the destroy variant needs to call the alias, if unprotected
+    std::string              destroyName;          // the name of the destroy variant, if there is one
+    std::string              enter;
+    CommandFlavour           flavour = CommandFlavour::Unsupported;
+    std::string              leave;
+    std::vector<size_t>      returnParamIndices;   // the non-const pointer parameters
+    std::set<size_t>         skippedParamIndices;  // the parameters the enhanced functions don't take
+    std::map<size_t, size_t> vectorParamIndices;
+  };
+
+  // the part of the functions wrapping a command that's emitted: the declarations within their class, or their
+  // definitions; with ENABLE_OUT_OF_LINE_DEFINITIONS, the header keeps the definitions of the function templates, and
+  // declares their default instantiations by extern templates, while the source gets the other definitions and those
+  // instantiations
+  enum class CommandPart
+  {
+    Declaration,
+    Definition,
+    ExternInstantiation,
+    SourceDefinition,
+    Instantiation
+  };
+
+  // the lookups shared by the passes of checkCorrectness, built once before they run
+  struct CorrectnessIndex
+  {
+    std::unordered_map<std::string, std::unordered_set<std::string>> enumValues;       // the values of each enum
+    std::unordered_set<std::string>                                  objectTypeEnums;  // of all the handles
+    std::unordered_set<std::string>                                  resultCodes;      // with their aliases
+    std::unordered_set<std::string>                                  sTypeValues;      // of all the structures
+  };
+
+  // the names derived from a name of the registry, determined once after reading the spec
+  struct DerivedNames
+  {
+    std::string argumentName;  // a parameter or member name without its "p" prefix, starting lower case
+    std::string commandName;   // the name of the function wrapping a command (or a command alias)
+    std::string strippedName;  // a type name without its STRUCT_PREFIX
+  };
+
+  // the names made of a prefix and a fixed part, determined once from the options, as they're compared against or
+  // emitted all over the place
+  struct PrefixedNames
+  {
+    PrefixedNames( GeneratorOptions const & options )
+      : defaultDispatcherType( options.headerMacro + "_DEFAULT_DISPATCHER_TYPE" )
+      , device( options.structPrefix + "Device" )
+      , incomplete( options.macroPrefix + "_INCOMPLETE" )
+      , objectType( options.structPrefix + "ObjectType" )
+      , physicalDevice( options.structPrefix + "PhysicalDevice" )
+      , result( options.structPrefix + "Result" )
+      , structureType( options.structPrefix + "StructureType" )
+      , success( options.macroPrefix + "_SUCCESS" )
+    {}
+
+    std::string defaultDispatcherType;  // like VULKAN_HPP_DEFAULT_DISPATCHER_TYPE
+    std::string device;                 // like VkDevice
+    std::string incomplete;             // like VK_INCOMPLETE
+    std::string objectType;             // like VkObjectType
+    std::string physicalDevice;         // like VkPhysicalDevice
+    std::string result;                 // like VkResult
+    std::string structureType;          // like VkStructureType
+    std::string success;                // like VK_SUCCESS
+  };
+
   struct EnumValueData
   {
     EnumValueData( int line, std::string const & vulkan, std::string const & vk, bool singleBit_ )
@@ -198,6 +370,13 @@ private:
     int                        xmlLine;
   };
 
+  // why an entity of the registry is kept: the entity it's reached from and how, or just how for a root
+  struct KeptReason
+  {
+    std::string from;
+    std::string relation;
+  };
+
   struct FuncPointerData
   {
     FuncPointerData( std::string const & r, int line ) : requirements( r ), xmlLine( line ) {}
@@ -285,8 +464,93 @@ private:
     std::string           feature;
   };
 
+  // the entities rendered into fragments of their own, that can be taken from a FragmentCache
+  enum class FragmentKind
+  {
+    Command,
+    Enum,
+    Handle,
+    Struct
+  };
+
+  // a handle or a structure to be emitted, listed after all the types it depends on
+  struct ListedType
+  {
+    ListedType( std::pair<const std::string, HandleData> const * handle_ ) : handle( handle_ ) {}
+    ListedType( std::pair<const std::string, StructureData> const * structure_ ) : structure( structure_ ) {}
+
+    std::pair<const std::string, HandleData> const *    handle    = nullptr;
+    std::pair<const std::string, StructureData> const * structure = nullptr;
+  };
+
+  // hands out a dense id for each name of the registry, in the order the names are first interned; the names are
+  // interned while reading the spec only, such that the generation threads can look them up concurrently
+  class NameTable
+  {
+  public:
+    static constexpr uint32_t npos = ~uint32_t( 0 );
+
+    uint32_t            find( std::string const & name ) const;  // npos for a name that has never been interned
+    std::string const & getName( uint32_t id ) const;
+    uint32_t            intern( std::string const & name );
+    size_t              size() const;
+
+  private:
+    size_t findSlot( std::string const & name, size_t hash ) const;
+    void   grow();
+
+  private:
+    std::vector<std::string> m_names;  // indexed by id
+    std::vector<uint32_t>    m_slots;  // open addressing with linear probing, npos marks an empty slot
+  };
+
+  // a map from names to Value that iterates in the order of the names, like the std::map it wraps, but finds its
+  // entries through a flat index over the ids of a NameTable
+  template <typename Value>
+  class NameMap
+  {
+    friend class SnapshotArchive;
+
+  public:
+    using const_iterator = typename std::map<std::string, Value>::const_iterator;
+    using iterator       = typename std::map<std::string, Value>::iterator;
+
+    explicit NameMap( NameTable & names ) : m_names( names ) {}
+    NameMap( NameMap const & ) = delete;  // the index refers to the entries of this very map
+    NameMap & operator=( NameMap const & ) = delete;
+
+    iterator       begin();
+    const_iterator begin() const;
+    bool           empty() const;
+    iterator       end();
+    const_iterator end() const;
+    iterator       erase( iterator it );
+    iterator       find( std::string const & name );
+    const_iterator find( std::string const & name ) const;
+    iterator       find( TypeInfo const & type );  // by the id of type, without hashing its name once it's known
+    const_iterator find( TypeInfo const & type ) const;
+    size_t         getFragmentSource() const;
+    template <typename Entry>
+    std::pair<iterator, bool> insert( Entry && entry );
+    void                      setFragmentSource( size_t source );  // the index its reads are recorded with
+    size_t                    size() const;
+
+  private:
+    void reindex();  // rebuilds m_index after m_entries has been changed as a whole
+
+  private:
+    std::map<std::string, Value> m_entries;
+    size_t                       m_fragmentSource = ~size_t( 0 );  // the index of this map in m_fragmentSources
+    std::vector<iterator>        m_index;  // indexed by the ids of m_names, end() for the names not in this map
+    NameTable &                  m_names;
+  };
+
 private:
-  void appendArgumentPlainType( std::string & str, ParamData const & paramData ) const;
+  template <typename Value>
+  void            addFragmentSource( NameMap<Value> & map );
+  CommandAnalysis analyzeCommand( std::string const & name, CommandData const & commandData ) const;
+  void            analyzeCommands();
+  void            appendArgumentPlainType( std::string & str, ParamData const & paramData ) const;
   void appendArguments( std::string &                    str,
                         CommandData const &              commandData,
                         size_t                           returnParamIndex,
@@ -312,7 +576,12 @@ private:
   void appendBitmaskToStringFunction( std::string &                      str,
                                       std::string const &                flagsName,
                                       std::string const &                enumName,
-                                      std::vector<EnumValueData> const & enumValues ) const;
+                                      std::vector<EnumValueData> const & enumValues,
+                                      bool                               definition ) const;
+  void appendCachedFragment( std::string &                                str,
+                             FragmentKind                                 kind,
+                             std::string const &                          name,
+                             std::function<void( std::string & )> const & appendFragment ) const;
   void appendCall( std::string &                    str,
                    std::string const &              name,
                    CommandData const &              commandData,
@@ -324,88 +593,114 @@ private:
   void appendCommand( std::string &       str,
                       std::string const & name,
                       CommandData const & commandData,
-                      bool                definition ) const;
-  void appendCommandChained( std::string &                    str,
-                             std::string const &              name,
-                             CommandData const &              commandData,
-                             bool                             definition,
-                             std::map<size_t, size_t> const & vectorParamIndices,
-                             size_t                           nonConstPointerIndex ) const;
-  void appendCommandSingular( std::string &                    str,
-                              std::string const &              name,
-                              CommandData const &              commandData,
-                              bool                             definition,
-                              std::map<size_t, size_t> const & vectorParamIndices,
-                              size_t                           returnParamIndex ) const;
+                      CommandPart         part ) const;
+  void appendCommandChained( std::string &           str,
+                             std::string const &     name,
+                             CommandData const &     commandData,
+                             std::string const &     enter,
+                             std::string const &     leave,
+                             CommandPart             part,
+                             CommandAnalysis const & analysis ) const;
+  void appendCommandDefinition( std::string &                                   str,
+                                std::pair<const std::string, CommandData> const & command,
+                                CommandPart                                     part ) const;
+  void appendCommandDefinitions( std::string & str, CommandPart definitionPart, CommandPart instantiationPart ) const;
+  void appendCommandFlavour( std::string &       str,
+                             std::string const & name,
+                             CommandData const & commandData,
+                             std::string const & enter,
+                             std::string const & leave,
+                             CommandPart         part ) const;
+  void appendCommandSingular( std::string &           str,
+                              std::string const &     name,
+                              CommandData const &     commandData,
+                              std::string const &     enter,
+                              std::string const &     leave,
+                              CommandPart             part,
+                              CommandAnalysis const & analysis ) const;
   void appendCommandStandard( std::string &       str,
                               std::string const & name,
                               CommandData const & commandData,
-                              bool                definition ) const;
-  void appendCommandStandardAndEnhanced( std::string &                    str,
-                                         std::string const &              name,
-                                         CommandData const &              commandData,
-                                         bool                             definition,
-                                         std::map<size_t, size_t> const & vectorParamIndices,
-                                         std::vector<size_t> const &      nonConstPointerParamIndices ) const;
-  void
-              appendCommandStandardEnhancedDeprecatedAllocator( std::string &                    str,
-                                                                std::string const &              name,
-                                                                CommandData const &              commandData,
-                                                                bool                             definition,
-                                                                std::map<size_t, size_t> const & vectorParamIndices,
-                                                                std::vector<size_t> const & nonConstPointerParamIndices ) const;
-  void        appendCommandStandardOrEnhanced( std::string &       str,
-                                               std::string const & name,
-                                               CommandData const & commandData,
-                                               bool                definition ) const;
-  void        appendCommandUnique( std::string &       str,
-                                   std::string const & name,
-                                   CommandData const & commandData,
-                                   size_t              nonConstPointerIndex,
-                                   bool                definition ) const;
-  void        appendCommandVector( std::string &                     str,
-                                   std::string const &               name,
-                                   CommandData const &               commandData,
-                                   bool                              definition,
-                                   std::pair<size_t, size_t> const & vectorParamIndex,
-                                   std::vector<size_t> const &       returnParamIndices ) const;
-  void        appendCommandVectorChained( std::string &                    str,
-                                          std::string const &              name,
-                                          CommandData const &              commandData,
-                                          bool                             definition,
-                                          std::map<size_t, size_t> const & vectorParamIndices,
-                                          std::vector<size_t> const &      returnParamIndices ) const;
-  void        appendCommandVectorDeprecated( std::string &                    str,
-                                             std::string const &              name,
-                                             CommandData const &              commandData,
-                                             std::map<size_t, size_t> const & vectorParamIndices,
-                                             std::vector<size_t> const &      returnParamIndices,
-                                             bool                             definition ) const;
-  void        appendCommandVectorSingularUnique( std::string &                    str,
-                                                 std::string const &              name,
-                                                 CommandData const &              commandData,
-                                                 std::map<size_t, size_t> const & vectorParamIndices,
-                                                 size_t                           returnParamIndex,
-                                                 bool                             definition ) const;
-  void        appendCommandVectorUnique( std::string &                    str,
-                                         std::string const &              name,
-                                         CommandData const &              commandData,
-                                         std::map<size_t, size_t> const & vectorParamIndices,
-                                         size_t                           returnParamIndex,
-                                         bool                             definition ) const;
+                              std::string const & enter,
+                              std::string const & leave,
+                              CommandPart         part ) const;
+  void appendCommandStandardAndEnhanced( std::string &           str,
+                                         std::string const &     name,
+                                         CommandData const &     commandData,
+                                         std::string const &     enter,
+                                         std::string const &     leave,
+                                         CommandPart             part,
+                                         CommandAnalysis const & analysis ) const;
+  void        appendCommandStandardEnhancedDeprecatedAllocator( std::string &           str,
+                                                                std::string const &     name,
+                                                                CommandData const &     commandData,
+                                                                std::string const &     enter,
+                                                                std::string const &     leave,
+                                                                CommandPart             part,
+                                                                CommandAnalysis const & analysis ) const;
+  void        appendCommandStandardOrEnhanced( std::string &           str,
+                                               std::string const &     name,
+                                               CommandData const &     commandData,
+                                               std::string const &     enter,
+                                               std::string const &     leave,
+                                               CommandPart             part,
+                                               CommandAnalysis const & analysis ) const;
+  void        appendCommandUnique( std::string &           str,
+                                   std::string const &     name,
+                                   CommandData const &     commandData,
+                                   std::string const &     enter,
+                                   std::string const &     leave,
+                                   CommandAnalysis const & analysis,
+                                   CommandPart             part ) const;
+  void        appendCommandVector( std::string &           str,
+                                   std::string const &     name,
+                                   CommandData const &     commandData,
+                                   std::string const &     enter,
+                                   std::string const &     leave,
+                                   CommandPart             part,
+                                   CommandAnalysis const & analysis ) const;
+  void        appendCommandVectorChained( std::string &           str,
+                                          std::string const &     name,
+                                          CommandData const &     commandData,
+                                          std::string const &     enter,
+                                          std::string const &     leave,
+                                          CommandPart             part,
+                                          CommandAnalysis const & analysis ) const;
+  void        appendCommandVectorDeprecated( std::string &           str,
+                                             std::string const &     name,
+                                             CommandData const &     commandData,
+                                             CommandAnalysis const & analysis,
+                                             CommandPart             part ) const;
+  void        appendCommandVectorSingularUnique( std::string &           str,
+                                                 std::string const &     name,
+                                                 CommandData const &     commandData,
+                                                 std::string const &     enter,
+                                                 std::string const &     leave,
+                                                 CommandAnalysis const & analysis,
+                                                 CommandPart             part ) const;
+  void        appendCommandVectorUnique( std::string &           str,
+                                         std::string const &     name,
+                                         CommandData const &     commandData,
+                                         std::string const &     enter,
+                                         std::string const &     leave,
+                                         CommandAnalysis const & analysis,
+                                         CommandPart             part ) const;
   void        appendDispatchLoaderDynamicCommand( std::string &       str,
                                                   std::string &       emptyFunctions,
                                                   std::string &       deviceFunctions,
                                                   std::string &       deviceFunctionsInstance,
                                                   std::string &       instanceFunctions,
                                                   std::string const & commandName,
-                                                  CommandData const & commandData );
+                                                  CommandData const & commandData ) const;
   void        appendEnum( std::string & str, std::pair<std::string, EnumData> const & enumData ) const;
   void        appendEnumInitializer( std::string &                      str,
                                      TypeInfo const &                   type,
                                      std::vector<std::string> const &   arraySizes,
                                      std::vector<EnumValueData> const & values ) const;
-  void        appendEnumToString( std::string & str, std::pair<std::string, EnumData> const & enumData ) const;
+  void        appendEnumToString( std::string &                      str,
+                                  std::string const &                enumName,
+                                  std::vector<EnumValueData> const & values,
+                                  bool                               definition ) const;
   std::string appendFunctionBodyEnhancedLocalReturnVariable( std::string &       str,
                                                              std::string const & indentation,
                                                              CommandData const & commandData,
@@ -445,8 +740,9 @@ private:
                                                           std::string const & strippedParameterName,
                                                           bool                hasSizeParam,
                                                           bool                isTemplateParam ) const;
-  void        appendHandle( std::string & str, std::pair<std::string, HandleData> const & handle );
-  void        appendStruct( std::string & str, std::pair<std::string, StructureData> const & structure );
+  void        appendHandle( std::string & str, std::pair<std::string, HandleData> const & handle ) const;
+  void        appendListedTypes( std::string & str, std::vector<ListedType> const & listedTypes ) const;
+  void        appendStruct( std::string & str, std::pair<std::string, StructureData> const & structure ) const;
   void        appendStructAssignmentOperators( std::string &                                 str,
                                                std::pair<std::string, StructureData> const & structure,
                                                std::string const &                           prefix ) const;
@@ -472,11 +768,14 @@ private:
                                           std::pair<std::string, StructureData> const & structData,
                                           std::string const &                           prefix ) const;
   void        appendStructure( std::string & str, std::pair<std::string, StructureData> const & structure ) const;
-  void        appendType( std::string & str, std::string const & typeName );
+  void        appendStructureLayoutChecks( std::string &                                 str,
+                                           std::pair<std::string, StructureData> const & structure ) const;
+  void        appendToHexString( std::string & str, bool definition ) const;
   void        appendUnion( std::string & str, std::pair<std::string, StructureData> const & structure ) const;
   void        appendUniqueTypes( std::string &                 str,
                                  std::string const &           parentType,
                                  std::set<std::string> const & childrenTypes ) const;
+  void        appendWithSizeMarks( std::string & str, std::string const & code ) const;  // along with its groups
   std::string constructArgumentListEnhanced( std::vector<ParamData> const & params,
                                              std::set<size_t> const &       skippedParams,
                                              size_t                         singularParam,
@@ -490,126 +789,144 @@ private:
                                               bool                           nonConstPointerAsNullptr,
                                               size_t                         singularParamIndex ) const;
   std::string constructCallArgumentsStandard( std::string const & handle, std::vector<ParamData> const & params ) const;
-  std::string constructCommandResult( std::string const &              name,
-                                      CommandData const &              commandData,
-                                      bool                             definition,
-                                      std::map<size_t, size_t> const & vectorParamIndices ) const;
+  std::string constructCommandPart( CommandPart                                              part,
+                                    std::string const &                                      definition,
+                                    std::vector<std::pair<std::string, std::string>> const & templateArguments ) const;
+  std::string constructCommandResult( std::string const &      name,
+                                      CommandData const &      commandData,
+                                      CommandPart              part,
+                                      std::set<size_t> const & skippedParameters ) const;
   std::string constructCommandResultEnumerate( std::string const &               name,
                                                CommandData const &               commandData,
-                                               bool                              definition,
+                                               CommandPart                       part,
+                                               std::set<size_t> const &          skippedParams,
                                                std::pair<size_t, size_t> const & vectorParamIndices,
                                                bool                              withAllocators ) const;
   std::string constructCommandResultEnumerateChained( std::string const &               name,
                                                       CommandData const &               commandData,
-                                                      bool                              definition,
+                                                      CommandPart                       part,
+                                                      std::set<size_t> const &          skippedParams,
                                                       std::pair<size_t, size_t> const & vectorParamIndex,
-                                                      std::vector<size_t> const &       returnParamIndices,
                                                       bool                              withAllocator ) const;
   std::string constructCommandResultEnumerateTwoVectors( std::string const &              name,
                                                          CommandData const &              commandData,
-                                                         bool                             definition,
+                                                         CommandPart                      part,
+                                                         std::set<size_t> const &         skippedParams,
                                                          std::map<size_t, size_t> const & vectorParamIndices,
-                                                         std::vector<size_t> const &      returnParamIndices,
                                                          bool                             withAllocators ) const;
   std::string constructCommandResultEnumerateTwoVectorsDeprecated( std::string const &              name,
                                                                    CommandData const &              commandData,
-                                                                   bool                             definition,
+                                                                   CommandPart                      part,
                                                                    std::map<size_t, size_t> const & vectorParamIndices,
                                                                    bool withAllocators ) const;
-  std::string constructCommandResultGetChain( std::string const & name,
-                                              CommandData const & commandData,
-                                              bool                definition,
-                                              size_t              nonConstPointerIndex ) const;
-  std::string constructCommandResultGetHandleUnique( std::string const & name,
-                                                     CommandData const & commandData,
-                                                     bool                definition,
-                                                     size_t              nonConstPointerIndex ) const;
+  std::string constructCommandResultGetChain( std::string const &      name,
+                                              CommandData const &      commandData,
+                                              CommandPart              part,
+                                              std::set<size_t> const & skippedParams,
+                                              size_t                   nonConstPointerIndex ) const;
+  std::string constructCommandResultGetHandleUnique( std::string const &      name,
+                                                     CommandData const &      commandData,
+                                                     CommandPart              part,
+                                                     std::set<size_t> const & skippedParams,
+                                                     size_t                   nonConstPointerIndex ) const;
   std::string constructCommandResultGetTwoVectors( std::string const &              name,
                                                    CommandData const &              commandData,
-                                                   bool                             definition,
+                                                   CommandPart                      part,
+                                                   std::set<size_t> const &         skippedParameters,
                                                    std::map<size_t, size_t> const & vectorParamIndices ) const;
-  std::string constructCommandResultGetValue( std::string const & name,
-                                              CommandData const & commandData,
-                                              bool                definition,
-                                              size_t              nonConstPointerIndex ) const;
+  std::string constructCommandResultGetValue( std::string const &      name,
+                                              CommandData const &      commandData,
+                                              CommandPart              part,
+                                              std::set<size_t> const & skippedParams,
+                                              size_t                   nonConstPointerIndex ) const;
   std::string constructCommandResultGetValueDeprecated( std::string const &              name,
                                                         CommandData const &              commandData,
-                                                        bool                             definition,
+                                                        CommandPart                      part,
                                                         std::map<size_t, size_t> const & vectorParamIndices,
                                                         size_t                           returnParamIndex ) const;
-  std::string constructCommandResultGetVector( std::string const &              name,
-                                               CommandData const &              commandData,
-                                               bool                             definition,
-                                               std::map<size_t, size_t> const & vectorParamIndices,
-                                               size_t                           returnParamIndex ) const;
+  std::string constructCommandResultGetVector( std::string const &      name,
+                                               CommandData const &      commandData,
+                                               CommandPart              part,
+                                               std::set<size_t> const & skippedParams,
+                                               size_t                   returnParamIndex ) const;
   std::string constructCommandResultGetVectorAndValue( std::string const &              name,
                                                        CommandData const &              commandData,
-                                                       bool                             definition,
+                                                       CommandPart                      part,
+                                                       std::set<size_t> const &         skippedParameters,
                                                        std::map<size_t, size_t> const & vectorParamIndices,
                                                        std::vector<size_t> const &      returnParamIndex,
                                                        bool                             withAllocator ) const;
   std::string constructCommandResultGetVectorDeprecated( std::string const &              name,
                                                          CommandData const &              commandData,
-                                                         bool                             definition,
+                                                         CommandPart                      part,
                                                          std::map<size_t, size_t> const & vectorParamIndices,
                                                          size_t                           returnParamIndex ) const;
   std::string constructCommandResultGetVectorOfHandles( std::string const &              name,
                                                         CommandData const &              commandData,
-                                                        bool                             definition,
+                                                        CommandPart                      part,
+                                                        std::set<size_t> const &         skippedParams,
                                                         std::map<size_t, size_t> const & vectorParamIndices,
                                                         size_t                           returnParamIndex,
                                                         bool                             withAllocator ) const;
   std::string constructCommandResultGetVectorOfHandlesSingular( std::string const &              name,
                                                                 CommandData const &              commandData,
-                                                                bool                             definition,
+                                                                CommandPart                      part,
                                                                 std::map<size_t, size_t> const & vectorParamIndices,
                                                                 size_t returnParamIndex ) const;
   std::string constructCommandResultGetVectorOfHandlesUnique( std::string const &              name,
                                                               CommandData const &              commandData,
-                                                              bool                             definition,
+                                                              CommandPart                      part,
+                                                              std::set<size_t> const &         skippedParams,
                                                               std::map<size_t, size_t> const & vectorParamIndices,
                                                               size_t                           returnParamIndex,
                                                               bool                             withAllocator ) const;
   std::string
               constructCommandResultGetVectorOfHandlesUniqueSingular( std::string const &              name,
                                                                       CommandData const &              commandData,
-                                                                      bool                             definition,
+                                                                      CommandPart                      part,
                                                                       std::map<size_t, size_t> const & vectorParamIndices,
                                                                       size_t                           returnParamIndex ) const;
   std::string constructCommandResultGetVectorSingular( std::string const &              name,
                                                        CommandData const &              commandData,
-                                                       bool                             definition,
+                                                       CommandPart                      part,
                                                        std::map<size_t, size_t> const & vectorParamIndices,
                                                        size_t                           returnParamIndex ) const;
   std::string
-    constructCommandStandard( std::string const & name, CommandData const & commandData, bool definition ) const;
-  std::string constructCommandType( std::string const & name, CommandData const & commandData, bool definition ) const;
+    constructCommandStandard( std::string const & name, CommandData const & commandData, CommandPart part ) const;
+  std::string constructCommandType( std::string const &      name,
+                                    CommandData const &      commandData,
+                                    CommandPart              part,
+                                    std::set<size_t> const & skippedParameters ) const;
   std::string constructCommandVoid( std::string const &              name,
                                     CommandData const &              commandData,
-                                    bool                             definition,
+                                    CommandPart                      part,
+                                    std::set<size_t> const &         skippedParameters,
                                     std::map<size_t, size_t> const & vectorParamIndices ) const;
   std::string constructCommandVoidEnumerate( std::string const &               name,
                                              CommandData const &               commandData,
-                                             bool                              definition,
+                                             CommandPart                       part,
+                                             std::set<size_t> const &          skippedParams,
                                              std::pair<size_t, size_t> const & vectorParamIndex,
-                                             std::vector<size_t> const &       returnParamIndices,
                                              bool                              withAllocators ) const;
   std::string constructCommandVoidEnumerateChained( std::string const &               name,
                                                     CommandData const &               commandData,
-                                                    bool                              definition,
+                                                    CommandPart                       part,
+                                                    std::set<size_t> const &          skippedParams,
                                                     std::pair<size_t, size_t> const & vectorParamIndex,
-                                                    std::vector<size_t> const &       returnParamIndices,
                                                     bool                              withAllocators ) const;
-  std::string constructCommandVoidGetChain( std::string const & name,
-                                            CommandData const & commandData,
-                                            bool                definition,
-                                            size_t              nonConstPointerIndex ) const;
+  std::string constructCommandVoidGetChain( std::string const &      name,
+                                            CommandData const &      commandData,
+                                            CommandPart              part,
+                                            std::set<size_t> const & skippedParams,
+                                            size_t                   nonConstPointerIndex ) const;
   std::string constructCommandVoidGetValue( std::string const &              name,
                                             CommandData const &              commandData,
-                                            bool                             definition,
+                                            CommandPart                      part,
+                                            std::set<size_t> const &         skippedParameters,
                                             std::map<size_t, size_t> const & vectorParamIndices,
                                             size_t                           returnParamIndex ) const;
   std::string constructConstexprString( std::pair<std::string, StructureData> const & structData, bool assignmentOperator ) const;
+  std::string constructFragmentKey( FragmentKind kind, std::string const & name ) const;
   std::string constructFunctionBodyEnhanced( std::string const &              indentation,
                                              std::string const &              name,
                                              CommandData const &              commandData,
@@ -633,20 +950,35 @@ private:
                                                         bool                             withAllocator ) const;
   std::string constructNoDiscardStandard( CommandData const & commandData ) const;
   std::string constructReturnType( CommandData const & commandData, std::string const & baseType ) const;
+  std::string constructStandardArrayWrapper( std::string const & type, std::vector<std::string> const & sizes ) const;
   std::string constructSuccessCheck( std::vector<std::string> const & successCodes ) const;
   std::string constructSuccessCodeList( std::vector<std::string> const & successCodes ) const;
   std::string constructVectorSizeCheck( std::string const &                           name,
                                         CommandData const &                           commandData,
                                         std::map<size_t, std::vector<size_t>> const & countToVectorMap,
                                         std::set<size_t> const &                      skippedParams ) const;
+  void        beginSizeGroup( std::string const & str, FragmentKind kind, std::string const & name ) const;
+  void        checkBaseTypeCorrectness() const;
+  void        checkBitmaskCorrectness() const;
+  void        checkCommandCorrectness( CorrectnessIndex const & index ) const;
   void        checkCorrectness();
-  bool        containsArray( std::string const & type ) const;
-  bool        containsUnion( std::string const & type ) const;
+  void        checkExtensionCorrectness() const;
+  void        checkFuncPointerCorrectness() const;
+  void        checkHandleCorrectness( CorrectnessIndex const & index ) const;
+  void        checkStructureCorrectness( CorrectnessIndex const & index ) const;
+  void        checkStructureTypeCorrectness( CorrectnessIndex const & index ) const;
+  bool        containsArray( StructureData const & structure ) const;
+  bool        containsUnion( StructureData const & structure ) const;
+  void        deriveNames();
   size_t      determineDefaultStartIndex( std::vector<ParamData> const & params,
                                           std::set<size_t> const &       skippedParams ) const;
+  std::vector<std::pair<std::string, std::string>>
+              determineDefaultTemplateArguments( std::vector<std::pair<std::string, std::string>> const & allocators,
+                                                 bool withAllocators ) const;
   std::string determineEnhancedReturnType( CommandData const & commandData,
                                            size_t              returnParamIndex,
                                            bool                isStructureChain ) const;
+  std::string determineNoDiscard( bool multiSuccessCodes, bool multiErrorCodes ) const;
   size_t      determineReturnParamIndex( CommandData const &              commandData,
                                          std::map<size_t, size_t> const & vectorParamIndices,
                                          bool                             twoStep ) const;
@@ -659,6 +991,10 @@ private:
   std::vector<size_t>      determineConstPointerParamIndices( std::vector<ParamData> const & params ) const;
   std::vector<size_t>      determineNonConstPointerParamIndices( std::vector<ParamData> const & params ) const;
   std::map<size_t, size_t> determineVectorParamIndicesNew( std::vector<ParamData> const & params ) const;
+  std::map<std::string, KeptReason> determineReachable( std::vector<std::pair<std::string, KeptReason>> pending,
+                                                        bool withExtendingStructs ) const;
+  std::string              determineSizeGroup( FragmentKind kind, std::string const & name ) const;
+  void                     endSizeGroup( std::string const & str ) const;  // back to the group begun before
   std::string
                                       generateLenInitializer( std::vector<MemberData>::const_iterator                                        mit,
                                                               std::map<std::vector<MemberData>::const_iterator,
@@ -667,133 +1003,172 @@ private:
   std::pair<std::string, std::string> generateProtection( std::string const &           feature,
                                                           std::set<std::string> const & extension ) const;
   std::pair<std::string, std::string> generateProtection( std::string const & type, bool isAliased ) const;
-  std::string           generateSizeCheck( std::vector<std::vector<MemberData>::const_iterator> const & arrayIts,
-                                           std::string const &                                          structName,
-                                           std::string const &                                          prefix,
-                                           bool mutualExclusiveLens ) const;
-  std::set<std::string> getPlatforms( std::set<std::string> const & extensions ) const;
+  std::string             generateSizeCheck( std::vector<std::vector<MemberData>::const_iterator> const & arrayIts,
+                                             std::string const &                                          structName,
+                                             std::string const &                                          prefix,
+                                             bool mutualExclusiveLens ) const;
+  std::string const &     getArgumentName( std::string const & name ) const;
+  CommandAnalysis const & getCommandAnalysis( std::string const & name ) const;
+  std::string const &     getCommandName( std::string const & name ) const;
+  DerivedNames const &    getDerivedNames( std::string const & name ) const;
+  DerivedNames const &    getDerivedNames( TypeInfo const & type ) const;
+  size_t                  getEmissionThreadCount() const;  // one with a size report, which needs the code in order
+  std::set<std::string>   getPlatforms( std::set<std::string> const & extensions ) const;
   std::pair<std::string, std::string> getPoolTypeAndName( std::string const & type ) const;
+  std::string const &                 getStrippedName( std::string const & name ) const;
+  std::string const &                 getStrippedName( TypeInfo const & type ) const;
   std::string                         getVectorSize( std::vector<ParamData> const &   params,
                                                      std::map<size_t, size_t> const & vectorParamIndices,
                                                      size_t                           returnParamIndex ) const;
-  bool                                isHandleType( std::string const & type ) const;
+  uint64_t                            hashFragmentReads( FragmentReads const & reads ) const;
+  bool                                isHandleType( TypeInfo const & type ) const;
   bool isLenByStructMember( std::string const & name, std::vector<ParamData> const & params ) const;
   bool isLenByStructMember( std::string const & name, ParamData const & param ) const;
   bool isParam( std::string const & name, std::vector<ParamData> const & params ) const;
-  bool isStructureChainAnchor( std::string const & type ) const;
+  bool isStructureChainAnchor( TypeInfo const & type ) const;
   bool needsComplexBody( CommandData const & commandData ) const;
   std::pair<bool, std::map<size_t, std::vector<size_t>>>
        needsVectorSizeCheck( std::map<size_t, size_t> const & vectorParamIndices ) const;
-  void readBaseType( tinyxml2::XMLElement const * element, std::map<std::string, std::string> const & attributes );
-  void readBitmask( tinyxml2::XMLElement const * element, std::map<std::string, std::string> const & attributes );
-  void readBitmaskAlias( tinyxml2::XMLElement const * element, std::map<std::string, std::string> const & attributes );
-  void readCommand( tinyxml2::XMLElement const * element );
-  void readCommand( tinyxml2::XMLElement const * element, std::map<std::string, std::string> const & attributess );
-  void readCommandAlias( tinyxml2::XMLElement const * element, std::map<std::string, std::string> const & attributes );
-  ParamData readCommandParam( tinyxml2::XMLElement const * element, std::vector<ParamData> const & params );
-  std::pair<std::string, std::string> readCommandProto( tinyxml2::XMLElement const * element );
-  void                                readCommands( tinyxml2::XMLElement const * element );
-  std::string                         readComment( tinyxml2::XMLElement const * element );
-  void readDefine( tinyxml2::XMLElement const * element, std::map<std::string, std::string> const & attributes );
-  void readEnum( tinyxml2::XMLElement const * element,
-                 EnumData &                   enumData,
-                 bool                         bitmask,
-                 std::string const &          prefix,
-                 std::string const &          postfix );
-  void readEnum( tinyxml2::XMLElement const *               element,
-                 std::map<std::string, std::string> const & attributes,
-                 EnumData &                                 enumData,
-                 bool                                       bitmask,
-                 std::string const &                        prefix,
-                 std::string const &                        postfix );
-  void readEnumAlias( tinyxml2::XMLElement const *               element,
-                      std::map<std::string, std::string> const & attributes,
-                      EnumData &                                 enumData,
-                      bool                                       bitmask,
-                      std::string const &                        prefix,
-                      std::string const &                        postfix );
-  void readEnumConstant( tinyxml2::XMLElement const * element );
-  void readEnums( tinyxml2::XMLElement const * element );
-  void readExtension( tinyxml2::XMLElement const * element );
-  void readExtensionDisabledCommand( tinyxml2::XMLElement const * element );
-  void readExtensionDisabledEnum( std::string const & extensionName, tinyxml2::XMLElement const * element );
-  void readExtensionDisabledRequire( std::string const & extensionName, tinyxml2::XMLElement const * element );
-  void readExtensionDisabledType( tinyxml2::XMLElement const * element );
-  void readExtensionRequire( tinyxml2::XMLElement const * element,
+  void orderTypes();  // sorts the handles and structures topologically, into m_orderedHandles and m_orderedStructs
+  void prepareEmission();
+  void pruneUnreachable( std::map<std::string, KeptReason> const & reachable );
+  void readBaseType( XmlNode const * element, XmlAttributes const & attributes );
+  void readBitmask( XmlNode const * element, XmlAttributes const & attributes );
+  void readBitmaskAlias( XmlNode const * element, XmlAttributes const & attributes );
+  void readCommand( XmlNode const * element );
+  void readCommand( XmlNode const * element, XmlAttributes const & attributess );
+  void readCommandAlias( XmlNode const * element, XmlAttributes const & attributes );
+  ParamData readCommandParam( XmlNode const * element, std::vector<ParamData> const & params );
+  std::pair<std::string, std::string> readCommandProto( XmlNode const * element );
+  void                                readCommands( XmlReader & reader, XmlNode const * element );
+  std::string                         readComment( XmlNode const * element );
+  void readDefine( XmlNode const * element, XmlAttributes const & attributes );
+  void readEnum( XmlNode const *     element,
+                 EnumData &          enumData,
+                 bool                bitmask,
+                 std::string const & prefix,
+                 std::string const & postfix );
+  void readEnum( XmlNode const *       element,
+                 XmlAttributes const & attributes,
+                 EnumData &            enumData,
+                 bool                  bitmask,
+                 std::string const &   prefix,
+                 std::string const &   postfix );
+  void readEnumAlias( XmlNode const *       element,
+                      XmlAttributes const & attributes,
+                      EnumData &            enumData,
+                      bool                  bitmask,
+                      std::string const &   prefix,
+                      std::string const &   postfix );
+  void readEnumConstant( XmlNode const * element );
+  void readEnums( XmlNode const * element );
+  void readExtension( XmlNode const * element );
+  void readExtensionDisabledCommand( XmlNode const * element );
+  void readExtensionDisabledEnum( std::string const & extensionName, XmlNode const * element );
+  void readExtensionDisabledRequire( std::string const & extensionName, XmlNode const * element );
+  void readExtensionDisabledType( XmlNode const * element );
+  void readExtensionRequire( XmlNode const *              element,
                              std::string const &          extension,
                              std::string const &          tag,
                              std::map<std::string, int> & requirements );
-  void readExtensionRequireCommand( tinyxml2::XMLElement const * element, std::string const & extension );
-  void readExtensionRequireType( tinyxml2::XMLElement const * element, std::string const & extension );
-  void readExtensions( tinyxml2::XMLElement const * element );
-  void readFeature( tinyxml2::XMLElement const * element );
-  void readFeatureRequire( tinyxml2::XMLElement const * element, std::string const & feature );
-  void readFeatureRequireCommand( tinyxml2::XMLElement const * element, std::string const & feature );
-  void readFeatureRequireType( tinyxml2::XMLElement const * element, std::string const & feature );
-  void readFuncpointer( tinyxml2::XMLElement const * element, std::map<std::string, std::string> const & attributes );
-  void readHandle( tinyxml2::XMLElement const * element, std::map<std::string, std::string> const & attributes );
-  std::pair<NameData, TypeInfo> readNameAndType( tinyxml2::XMLElement const * elements );
-  void                          readPlatform( tinyxml2::XMLElement const * element );
-  void                          readPlatforms( tinyxml2::XMLElement const * element );
-  void                          readRegistry( tinyxml2::XMLElement const * element );
-  void                          readRequireEnum( tinyxml2::XMLElement const * element, std::string const & tag );
-  void                          readRequireEnum( tinyxml2::XMLElement const *               element,
-                                                 std::map<std::string, std::string> const & attributes,
-                                                 std::string const &                        tag );
-  void                          readRequireEnumAlias( tinyxml2::XMLElement const *               element,
-                                                      std::map<std::string, std::string> const & attributes,
-                                                      std::string const &                        tag );
-  void readRequires( tinyxml2::XMLElement const * element, std::map<std::string, std::string> const & attributes );
-  void readSPIRVCapability( tinyxml2::XMLElement const * element );
-  void readSPIRVCapabilityEnable( tinyxml2::XMLElement const * element );
-  void readSPIRVCapabilityEnableExtension( int xmlLine, std::map<std::string, std::string> const & attributes );
-  void readSPIRVCapabilityEnableProperty( int xmlLine, std::map<std::string, std::string> const & attributes );
-  void readSPIRVCapabilityEnableStruct( int xmlLine, std::map<std::string, std::string> const & attributes );
-  void readSPIRVCapabilityEnableVersion( int xmlLine, std::map<std::string, std::string> const & attributes );
-  void readSPIRVCapabilities( tinyxml2::XMLElement const * element );
-  void readSPIRVExtension( tinyxml2::XMLElement const * element );
-  void readSPIRVExtensionEnable( tinyxml2::XMLElement const * element );
-  void readSPIRVExtensions( tinyxml2::XMLElement const * element );
-  void readStruct( tinyxml2::XMLElement const *               element,
-                   bool                                       isUnion,
-                   std::map<std::string, std::string> const & attributes );
-  void readStructAlias( tinyxml2::XMLElement const * element, std::map<std::string, std::string> const & attributes );
-  void readStructMember( tinyxml2::XMLElement const * element, std::vector<MemberData> & members, bool isUnion );
-  void readStructMemberEnum( tinyxml2::XMLElement const * element, MemberData & memberData );
-  void readStructMemberName( tinyxml2::XMLElement const *    element,
+  void readExtensionRequireCommand( XmlNode const * element, std::string const & extension );
+  void readExtensionRequireType( XmlNode const * element, std::string const & extension );
+  void readExtensions( XmlReader & reader, XmlNode const * element );
+  void readFeature( XmlNode const * element );
+  void readFeatureRequire( XmlNode const * element, std::string const & feature );
+  void readFeatureRequireCommand( XmlNode const * element, std::string const & feature );
+  void readFeatureRequireType( XmlNode const * element, std::string const & feature );
+  void readFuncpointer( XmlNode const * element, XmlAttributes const & attributes );
+  void readHandle( XmlNode const * element, XmlAttributes const & attributes );
+  std::pair<NameData, TypeInfo> readNameAndType( XmlNode const * elements );
+  void                          readPlatform( XmlNode const * element );
+  void                          readPlatforms( XmlNode const * element );
+  void                          readRegistry( XmlReader & reader, XmlNode const * element );
+  void                          readRequireEnum( XmlNode const * element, std::string const & tag );
+  void                          readRequireEnum( XmlNode const *       element,
+                                                 XmlAttributes const & attributes,
+                                                 std::string const &   tag );
+  void                          readRequireEnumAlias( XmlNode const *       element,
+                                                      XmlAttributes const & attributes,
+                                                      std::string const &   tag );
+  void readRequires( XmlNode const * element, XmlAttributes const & attributes );
+  void readSPIRVCapability( XmlNode const * element );
+  void readSPIRVCapabilityEnable( XmlNode const * element );
+  void readSPIRVCapabilityEnableExtension( int xmlLine, XmlAttributes const & attributes );
+  void readSPIRVCapabilityEnableProperty( int xmlLine, XmlAttributes const & attributes );
+  void readSPIRVCapabilityEnableStruct( int xmlLine, XmlAttributes const & attributes );
+  void readSPIRVCapabilityEnableVersion( int xmlLine, XmlAttributes const & attributes );
+  void readSPIRVCapabilities( XmlNode const * element );
+  void readSPIRVExtension( XmlNode const * element );
+  void readSPIRVExtensionEnable( XmlNode const * element );
+  void readSPIRVExtensions( XmlNode const * element );
+  void readStruct( XmlNode const * element, bool isUnion, XmlAttributes const & attributes );
+  void readStructAlias( XmlNode const * element, XmlAttributes const & attributes );
+  void readStructMember( XmlNode const * element, std::vector<MemberData> & members, bool isUnion );
+  void readStructMemberEnum( XmlNode const * element, MemberData & memberData );
+  void readStructMemberName( XmlNode const *                 element,
                              MemberData &                    memberData,
                              std::vector<MemberData> const & members );
-  void readStructMemberType( tinyxml2::XMLElement const * element, MemberData & memberData );
-  void readTag( tinyxml2::XMLElement const * element );
-  void readTags( tinyxml2::XMLElement const * element );
-  void readType( tinyxml2::XMLElement const * element );
-  void readTypeEnum( tinyxml2::XMLElement const * element, std::map<std::string, std::string> const & attributes );
-  void readTypeInclude( tinyxml2::XMLElement const * element, std::map<std::string, std::string> const & attributes );
-  void readTypes( tinyxml2::XMLElement const * element );
+  void readStructMemberType( XmlNode const * element, MemberData & memberData );
+  void readTag( XmlNode const * element );
+  void readTags( XmlNode const * element );
+  void readType( XmlNode const * element );
+  void readTypeEnum( XmlNode const * element, XmlAttributes const & attributes );
+  void readTypeInclude( XmlNode const * element, XmlAttributes const & attributes );
+  void readTypes( XmlReader & reader, XmlNode const * element );
   void registerDeleter( std::string const & name, std::pair<std::string, CommandData> const & commandData );
+  void selectSubset();  // drops everything the subset options don't ask for, and nothing the rest depends on
   void setVulkanLicenseHeader( int line, std::string const & comment );
+  std::string toString( CommandFlavour flavour ) const;
+  std::string toString( FragmentKind kind ) const;
   std::string toString( TypeCategory category );
 
 private:
-  std::map<std::string, BaseTypeData>    m_baseTypes;
-  std::map<std::string, BitmaskData>     m_bitmasks;
-  std::map<std::string, CommandData>     m_commands;
+  NameTable                              m_names;  // needs to be initialized before the NameMaps referring to it
+  NameMap<BaseTypeData>                  m_baseTypes{ m_names };
+  NameMap<std::string>                   m_bitmaskAliases{ m_names };  // from the alias to the aliased bitmask
+  NameMap<BitmaskData>                   m_bitmasks{ m_names };
+  NameMap<std::string>                   m_commandAliases{ m_names };   // from the alias to the aliased command
+  NameMap<CommandAnalysis>               m_commandAnalyses{ m_names };  // for the commands and the command aliases
+  NameMap<CommandData>                   m_commands{ m_names };
   std::set<std::string>                  m_constants;
   std::set<std::string>                  m_defines;
-  std::map<std::string, EnumData>        m_enums;
+  std::vector<DerivedNames>              m_derivedNames;  // indexed by the ids of m_names
+  NameMap<std::string>                   m_enumAliases{ m_names };   // from the alias to the aliased enum
+  NameMap<std::string>                   m_enumBitmasks{ m_names };  // from an enum to the bitmask requiring it
+  NameMap<EnumData>                      m_enums{ m_names };
   std::set<std::string>                  m_extendedStructs;  // structs which are referenced by the structextends tag
   std::map<std::string, ExtensionData>   m_extensions;
   std::map<std::string, std::string>     m_features;
-  std::map<std::string, FuncPointerData> m_funcPointers;
-  std::map<std::string, HandleData>      m_handles;
+  FragmentCache *                        m_fragmentCache       = nullptr;
+  size_t                                 m_fragmentCacheTarget = 0;  // the target the fragments are used by
+  std::string                            m_fragmentContext;  // the part of the key shared by all the fragments
+  mutable std::map<std::pair<size_t, std::string>, uint64_t>
+    m_fragmentReadHashes;  // the hash of each entry read by a fragment, as the state doesn't change while emitting
+  mutable std::mutex                     m_fragmentReadHashesMutex;  // guards m_fragmentReadHashes
+  std::vector<std::function<void( std::string &, std::string const & )>>
+    m_fragmentSources;  // append an entry read by a fragment to a key, for each container a fragment reads from
+  NameMap<FuncPointerData>               m_funcPointers{ m_names };
+  NameMap<std::string>                   m_handleAliases{ m_names };  // from the alias to the aliased handle
+  NameMap<HandleData>                    m_handles{ m_names };
   std::set<std::string>                  m_includes;
-  std::set<std::string>                  m_listedTypes;
-  std::set<std::string>                  m_listingTypes;
+  std::map<std::string, KeptReason>      m_keptReasons;  // filled by selectUsed only
+  GeneratorOptions                       m_options;
+  std::vector<ListedType>                m_orderedHandles;  // the handles no structure depends on
+  std::vector<ListedType>                m_orderedStructs;  // the structures and the handles they depend on
   std::map<std::string, PlatformData>    m_platforms;
-  std::map<std::string, std::string>     m_structureAliases;
-  std::map<std::string, StructureData>   m_structures;
+  PrefixedNames                          m_prefixedNames;  // needs to be initialized after m_options
+  Profiler *                             m_profiler = nullptr;
+  mutable std::vector<std::pair<std::string const *, std::string>>
+    m_sizeGroups;  // the group each begun one interrupted in its string, the latest last
+  mutable std::map<std::string const *, SizeMarks>
+    m_sizeMarks;  // the groups of the code in each string it's emitted to, with a size report
+  SizeReport *                           m_sizeReport = nullptr;
+  NameMap<std::string>                   m_structureAliases{ m_names };  // from the alias to the aliased structure
+  NameMap<StructureData>                 m_structures{ m_names };
   std::set<std::string>                  m_tags;
-  std::map<std::string, TypeData>        m_types;
+  NameMap<TypeData>                      m_types{ m_names };
+  size_t                                 m_threadCount = 1;
   std::string                            m_typesafeCheck;
   std::string                            m_version;
   std::string                            m_vulkanLicenseHeader;